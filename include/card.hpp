@@ -21,6 +21,9 @@ public:
     uint8_t getValue() const { return value; }
 
     std::string toString() const;
+    std::string toShortString() const;  // e.g. "Th", "As"
+
+    static Card fromString(const std::string& text);  // Parses "Th", "10h" or "as"; throws on bad input
 };
 
 #endif // CARD_HPP
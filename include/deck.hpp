@@ -14,6 +14,7 @@ class Deck {
   Deck();  // Constructor initializes a standard 52-card deck
 
   void shuffle();                            // Shuffles the deck
+  void shuffle(std::mt19937& g);             // Shuffles with a caller-owned generator
   Card dealCard();                           // Deals one card from the deck
   std::vector<Card> dealHand(int handSize);  // Add this method
   void reset();                              // Resets the deck to original state
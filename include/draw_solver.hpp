@@ -0,0 +1,67 @@
+#ifndef DRAW_SOLVER_HPP
+#define DRAW_SOLVER_HPP
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <unordered_map>
+#include "hand.hpp"
+#include "job.hpp"
+
+// Payout per final HandType. HandType does not separate low and high pairs, so any pair pays.
+using DrawPaytable = std::array<double, static_cast<size_t>(HandType::Count)>;
+const DrawPaytable& defaultDrawPaytable();  // 800/50/25/9/6/4/3/2/1/0
+
+// Final hand distribution over every possible replacement draw for one discard choice
+struct DrawOutcome {
+  std::array<uint32_t, static_cast<size_t>(HandType::Count)> counts{};
+
+  uint32_t total() const;
+  double expectedValue(const DrawPaytable& paytable) const;
+};
+
+// Discard masks use bit i for cards[i]; mask 0 stands pat and mask 31 draws five new cards
+struct DrawAnalysis {
+  std::array<uint8_t, 5> cards{};
+  std::array<DrawOutcome, 32> byDiscard;
+  uint8_t bestDiscard = 0;
+};
+
+struct DrawChoice {
+  uint8_t discard = 0;
+  uint8_t classSize = 0;  // Dealt hands in this suit-isomorphism class (1 to 24)
+  DrawOutcome outcome;
+};
+
+// Optimal choice for every suit-isomorphism class of dealt hands (134,459 classes)
+struct DrawTable {
+  std::unordered_map<uint32_t, DrawChoice> classes;  // Keyed by the canonical hand encoding
+
+  DrawChoice lookup(const std::array<uint8_t, 5>& cards) const;  // Discard mask is in the order of `cards`
+  double meanExpectedValue(const DrawPaytable& paytable) const;   // Over all C(52,5) dealt hands
+  void merge(const DrawTable& other) { classes.insert(other.classes.begin(), other.classes.end()); }
+};
+
+// Five-card draw solver. The constructor counts, for every set of up to four cards, how many
+// of the C(52,5) hands containing it reach each HandType (about a second of work, 12 MB).
+// The distribution for a discard then follows by inclusion-exclusion over the discarded cards,
+// so no replacement draw is ever dealt out individually.
+class DrawSolver {
+ public:
+  explicit DrawSolver(const DrawPaytable& paytable = defaultDrawPaytable());
+
+  DrawAnalysis analyze(const std::array<uint8_t, 5>& cards) const;  // Throws on duplicate or invalid cards
+  JobHandle<DrawTable> submitFullTable(const JobOptions& options = JobOptions()) const;
+  void writeTable(const DrawTable& table, std::ostream& out) const;  // One line per dealt hand
+
+  const DrawPaytable& getPaytable() const { return paytable; }
+
+  struct SubsetCounts;
+
+ private:
+  DrawPaytable paytable;
+  std::shared_ptr<const SubsetCounts> counts;
+};
+
+#endif  // DRAW_SOLVER_HPP
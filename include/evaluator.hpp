@@ -0,0 +1,46 @@
+#ifndef EVALUATOR_HPP
+#define EVALUATOR_HPP
+
+#include <cstdint>
+#include "hand.hpp"
+
+// Evaluation state that is extended one card at a time. It is a few bytes and cheap to
+// copy, so nested enumeration loops keep one per depth instead of re-evaluating hands.
+struct EvalState {
+  uint16_t rankMask = 0;  // Ranks seen at least once
+  uint16_t pairMask = 0;  // Ranks seen at least twice
+  uint16_t tripMask = 0;  // Ranks seen at least three times
+  uint16_t quadMask = 0;  // Ranks seen four times
+  uint8_t suitMask = 0;   // One bit per suit present
+
+  EvalState add(uint8_t card) const {
+    EvalState next = *this;
+    uint16_t bit = static_cast<uint16_t>(1u << (card >> 2));
+    if (tripMask & bit)
+      next.quadMask |= bit;
+    else if (pairMask & bit)
+      next.tripMask |= bit;
+    else if (rankMask & bit)
+      next.pairMask |= bit;
+    next.rankMask |= bit;
+    next.suitMask |= static_cast<uint8_t>(1u << (card & 0x3));
+    return next;
+  }
+
+  // Same classification as Hand::getHandType; only valid once exactly five cards are added
+  HandType handType() const {
+    if (quadMask) return HandType::FourOfAKind;
+    if (tripMask) return pairMask != tripMask ? HandType::FullHouse : HandType::ThreeOfAKind;
+    if (pairMask) return (pairMask & (pairMask - 1)) ? HandType::TwoPair : HandType::OnePair;
+
+    bool flush = (suitMask & (suitMask - 1)) == 0;
+    unsigned lowest = rankMask & (0u - rankMask);
+    bool straight = rankMask == 0x100F || rankMask / lowest == 0x1F;  // A-2-3-4-5 or five in a row
+    if (flush && straight) return rankMask == 0x1F00 ? HandType::RoyalFlush : HandType::StraightFlush;
+    if (flush) return HandType::Flush;
+    if (straight) return HandType::Straight;
+    return HandType::HighCard;
+  }
+};
+
+#endif  // EVALUATOR_HPP
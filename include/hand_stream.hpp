@@ -0,0 +1,116 @@
+#ifndef HAND_STREAM_HPP
+#define HAND_STREAM_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Recorded hand streams. A 64-byte header is followed by fixed-size blocks, so block i lives
+// at HEADER_SIZE + i * blockBytes and the header doubles as the index:
+//   "PPHS", u32 version, u32 cards per hand, u32 hands per block,
+//   u64 total hands, u64 block count, u64 bytes per block
+// Inside a block, hands are a little-endian bit stream of 6-bit cards (Card's rank << 2 | suit).
+// Every block ends with one spare word so readers can always load 8 bytes at a time.
+// Blocks are written and read in host byte order, which must be little-endian.
+// The header is written last, so a recording that stopped early is never read as complete.
+
+const size_t HAND_STREAM_HEADER_SIZE = 64;
+
+// One block of packed hands, filled by a single chunk
+class HandBlock {
+ public:
+  HandBlock(int cardsPerHand, uint32_t handsPerBlock);
+
+  void add(const uint8_t* cards);
+  const std::vector<uint64_t>& getWords() const { return words; }
+
+  static size_t bytesPerBlock(int cardsPerHand, uint32_t handsPerBlock);
+
+ private:
+  unsigned bitsPerHand;
+  size_t count = 0;
+  std::vector<uint64_t> words;
+};
+
+// Writes blocks to their final position as chunks finish, in any order and from any thread.
+// Each block must be written exactly once; the header follows the last one.
+class HandStreamWriter {
+ public:
+  HandStreamWriter(const std::string& path, int cardsPerHand, unsigned long long totalHands,
+                   uint32_t handsPerBlock);
+
+  HandBlock newBlock() const { return HandBlock(cardsPerHand, handsPerBlock); }
+  void write(size_t block, const HandBlock& hands);
+
+ private:
+  void writeHeader();
+
+  std::mutex mutex;
+  std::ofstream out;
+  std::string path;
+  int cardsPerHand;
+  uint32_t handsPerBlock;
+  unsigned long long totalHands;
+  size_t blockCount;
+  size_t blockBytes;
+  size_t blocksWritten = 0;
+};
+
+// Read-only memory mapping of a recorded stream; blocks are decoded in place
+class HandStream {
+ public:
+  explicit HandStream(const std::string& path);
+  ~HandStream();
+
+  HandStream(const HandStream&) = delete;
+  HandStream& operator=(const HandStream&) = delete;
+
+  int getCardsPerHand() const { return cardsPerHand; }
+  unsigned long long getTotalHands() const { return totalHands; }
+  size_t getBlockCount() const { return blockCount; }
+  size_t handsInBlock(size_t block) const;
+
+  // Calls fn(const uint8_t* cards) for every hand in the block; throws on cards outside the deck
+  template <typename Fn>
+  void forEachHand(size_t block, Fn fn) const {
+    const unsigned char* base = data + HAND_STREAM_HEADER_SIZE + block * blockBytes;
+    const size_t hands = handsInBlock(block);
+    const unsigned bitsPerHand = 6 * cardsPerHand;
+    const uint64_t handMask = (uint64_t(1) << bitsPerHand) - 1;
+    uint8_t cards[7];
+
+    for (size_t i = 0; i < hands; ++i) {
+      size_t bit = i * bitsPerHand;
+      uint64_t word;
+      std::memcpy(&word, base + (bit >> 3), sizeof(word));
+      word = (word >> (bit & 7)) & handMask;
+      for (int c = 0; c < cardsPerHand; ++c) {
+        cards[c] = static_cast<uint8_t>(word >> (6 * c) & 0x3F);
+        if (cards[c] >= 52) throw std::runtime_error("Corrupt hand stream: " + path);
+      }
+      fn(static_cast<const uint8_t*>(cards));
+    }
+  }
+
+ private:
+  void unmap();
+
+  std::string path;
+  const unsigned char* data = nullptr;
+  size_t size = 0;
+  int cardsPerHand = 0;
+  uint32_t handsPerBlock = 0;
+  unsigned long long totalHands = 0;
+  size_t blockCount = 0;
+  size_t blockBytes = 0;
+#ifdef _WIN32
+  void* fileHandle = nullptr;
+  void* mappingHandle = nullptr;
+#endif
+};
+
+#endif  // HAND_STREAM_HPP
@@ -0,0 +1,37 @@
+#ifndef HISTOGRAM_HPP
+#define HISTOGRAM_HPP
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "strength.hpp"
+
+// Per-chunk counters. 32 bits are plenty for one chunk and halve the cache footprint;
+// the alignment keeps each worker's counters off cache lines used by anything else.
+struct alignas(64) StrengthChunkCounts {
+  std::array<uint32_t, NUM_STRENGTH_CLASSES> counts{};
+  void addHand(uint16_t strengthClass) { counts[strengthClass]++; }
+};
+
+// Hands counted per strength class (see strengthClass), for 5- or 7-card hands
+struct StrengthHistogram {
+  int cardsPerHand = 5;
+  std::vector<unsigned long long> counts = std::vector<unsigned long long>(NUM_STRENGTH_CLASSES);
+
+  StrengthHistogram() = default;
+  explicit StrengthHistogram(int cardsPerHand) : cardsPerHand(cardsPerHand) {}
+
+  void merge(const StrengthChunkCounts& chunk);
+  void merge(const StrengthHistogram& other);  // Throws if the hand sizes differ
+
+  unsigned long long total() const;
+  std::vector<double> cumulative() const;  // [i]: fraction of hands in class i or stronger
+  std::array<unsigned long long, static_cast<size_t>(HandType::Count)> byHandType() const;
+
+  // Little-endian binary: "PPSH", u32 version, u32 cards per hand, u32 class count, u64 counts
+  void save(const std::string& path) const;
+  static StrengthHistogram load(const std::string& path);
+};
+
+#endif  // HISTOGRAM_HPP
@@ -0,0 +1,163 @@
+#ifndef JOB_HPP
+#define JOB_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include "thread_pool.hpp"
+
+struct JobOptions {
+  std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+  uint64_t seed = 0;  // 0 draws a fresh seed from std::random_device
+
+  static JobOptions withTimeout(std::chrono::steady_clock::duration timeout) {
+    JobOptions options;
+    options.deadline = std::chrono::steady_clock::now() + timeout;
+    return options;
+  }
+};
+
+// Thrown from JobHandle::get() when a job was cancelled or ran past its deadline
+class JobCancelled : public std::runtime_error {
+ public:
+  using std::runtime_error::runtime_error;
+};
+
+// State shared between a job's chunks and its handle: stop flag, deadline and progress
+class JobControl {
+ public:
+  JobControl(unsigned long long totalUnits, std::chrono::steady_clock::time_point deadline)
+      : totalUnits(totalUnits), deadline(deadline) {}
+
+  void cancel() { cancelled.store(true, std::memory_order_relaxed); }
+  bool isCancelled() const { return cancelled.load(std::memory_order_relaxed); }
+  bool deadlinePassed() const { return std::chrono::steady_clock::now() >= deadline; }
+  bool stopRequested() const { return isCancelled() || deadlinePassed(); }
+
+  void addProgress(unsigned long long units) { doneUnits.fetch_add(units, std::memory_order_relaxed); }
+  double progress() const {
+    if (totalUnits == 0) return 1.0;
+    return static_cast<double>(doneUnits.load(std::memory_order_relaxed)) / totalUnits;
+  }
+
+ private:
+  std::atomic<bool> cancelled{false};
+  std::atomic<unsigned long long> doneUnits{0};
+  const unsigned long long totalUnits;
+  const std::chrono::steady_clock::time_point deadline;
+};
+
+template <typename Result>
+class JobHandle {
+ public:
+  JobHandle(std::shared_ptr<JobControl> control, std::shared_future<Result> future)
+      : control(std::move(control)), future(std::move(future)) {}
+
+  void cancel() { control->cancel(); }
+  double progress() const { return control->progress(); }
+  bool isReady() const { return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }
+  void wait() const { future.wait(); }
+  template <typename Rep, typename Period>
+  bool waitFor(const std::chrono::duration<Rep, Period>& timeout) const {
+    return future.wait_for(timeout) == std::future_status::ready;
+  }
+
+  const Result& get() const { return future.get(); }  // Rethrows JobCancelled or a chunk's exception
+  std::shared_future<Result> getFuture() const { return future; }
+
+ private:
+  std::shared_ptr<JobControl> control;
+  std::shared_future<Result> future;
+};
+
+namespace detail {
+
+// Runs each chunk into a fresh Local and merges it into Result under the job's own mutex
+template <typename Result, typename Local>
+class Job : public PoolTask {
+ public:
+  using ChunkFn = std::function<void(size_t, Local&, JobControl&)>;
+
+  Job(size_t chunks, std::shared_ptr<JobControl> control, ChunkFn fn, Result initial)
+      : chunks(chunks),
+        remaining(chunks),
+        control(std::move(control)),
+        fn(std::move(fn)),
+        result(std::move(initial)) {}
+
+  size_t chunkCount() const override { return chunks; }
+
+  void runChunk(size_t chunk) override {
+    if (control->stopRequested()) {
+      aborted.store(true, std::memory_order_relaxed);
+    } else {
+      try {
+        Local local{};
+        fn(chunk, local, *control);
+        if (control->stopRequested()) {
+          aborted.store(true, std::memory_order_relaxed);
+        } else {
+          std::lock_guard<std::mutex> lock(mutex);
+          result.merge(local);
+        }
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!error) error = std::current_exception();
+        control->cancel();
+      }
+    }
+    if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) finish();
+  }
+
+  void finish() {
+    if (error) {
+      promise.set_exception(error);
+    } else if (aborted.load(std::memory_order_relaxed)) {
+      const char* reason = control->isCancelled() ? "job cancelled" : "job deadline exceeded";
+      promise.set_exception(std::make_exception_ptr(JobCancelled(reason)));
+    } else {
+      promise.set_value(std::move(result));
+    }
+  }
+
+  std::promise<Result> promise;
+
+ private:
+  const size_t chunks;
+  std::atomic<size_t> remaining;
+  std::atomic<bool> aborted{false};
+  std::shared_ptr<JobControl> control;
+  ChunkFn fn;
+  std::mutex mutex;
+  Result result;
+  std::exception_ptr error;
+};
+
+}  // namespace detail
+
+// Splits work into `chunks` pieces run on the shared ThreadPool. Each chunk fills a
+// default-constructed Local, which is merged into the result via Result::merge(const Local&).
+// Chunk functions should poll control.stopRequested() and report progress in the same
+// units as totalUnits.
+template <typename Result, typename Local = Result, typename ChunkFn>
+JobHandle<Result> submitJob(size_t chunks, unsigned long long totalUnits, ChunkFn fn,
+                            const JobOptions& options = JobOptions(), Result initial = Result()) {
+  auto control = std::make_shared<JobControl>(totalUnits, options.deadline);
+  auto job = std::make_shared<detail::Job<Result, Local>>(chunks, control, std::move(fn), std::move(initial));
+  JobHandle<Result> handle(control, job->promise.get_future().share());
+  if (chunks == 0) {
+    job->finish();
+  } else {
+    ThreadPool::instance().submit(job);
+  }
+  return handle;
+}
+
+#endif  // JOB_HPP
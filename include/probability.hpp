@@ -12,10 +12,15 @@ struct HandTypeCounts {
         for (const auto& count : counts) total += count;
         return total > 0 ? static_cast<double>(counts[static_cast<size_t>(type)]) / total : 0.0;
     }
+    void merge(const HandTypeCounts& other) {
+        for (size_t i = 0; i < counts.size(); ++i) counts[i] += other.counts[i];
+    }
 };
 
+// Blocking wrappers around submitSimulation (probability_jobs.hpp)
 HandTypeCounts calculateAllProbabilities(int totalHands = 1000000);
 double calculateHandTypeProbability(HandType type, int totalHands = 1000000);
+
 double getTheoreticalProbability(HandType type);
 
 #endif  // PROBABILITY_HPP
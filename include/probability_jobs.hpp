@@ -0,0 +1,31 @@
+#ifndef PROBABILITY_JOBS_HPP
+#define PROBABILITY_JOBS_HPP
+
+// Kept apart from probability.hpp so the CUDA translation unit only sees HandTypeCounts
+
+#include <memory>
+#include <string>
+#include "hand_stream.hpp"
+#include "histogram.hpp"
+#include "job.hpp"
+#include "probability.hpp"
+
+// Asynchronous entry points; all run on the shared ThreadPool. A non-empty recordPath also
+// writes every dealt hand to a hand stream that submitReplay/submitStrengthReplay can read back.
+JobHandle<HandTypeCounts> submitSimulation(int totalHands, const JobOptions& options = JobOptions(),
+                                           const std::string& recordPath = std::string());
+JobHandle<HandTypeCounts> submitEnumeration(const JobOptions& options = JobOptions());  // All C(52,5) hands
+
+// Strength-class histograms of 5- to 7-card hands
+JobHandle<StrengthHistogram> submitStrengthSimulation(int totalHands, int cardsPerHand,
+                                                      const JobOptions& options = JobOptions(),
+                                                      const std::string& recordPath = std::string());
+JobHandle<StrengthHistogram> submitStrengthEnumeration(int cardsPerHand, const JobOptions& options = JobOptions());
+
+// Re-evaluate recorded hands, one chunk per stream block; submitReplay needs 5-card hands
+JobHandle<HandTypeCounts> submitReplay(std::shared_ptr<const HandStream> stream,
+                                       const JobOptions& options = JobOptions());
+JobHandle<StrengthHistogram> submitStrengthReplay(std::shared_ptr<const HandStream> stream,
+                                                  const JobOptions& options = JobOptions());
+
+#endif  // PROBABILITY_JOBS_HPP
@@ -0,0 +1,17 @@
+#ifndef STRENGTH_HPP
+#define STRENGTH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "hand.hpp"
+
+// Number of distinct five-card hand strengths once suits are ignored
+const size_t NUM_STRENGTH_CLASSES = 7462;
+
+// Strength class of the best five-card hand among `count` (5 to 7) cards.
+// Class 0 is a royal flush and class 7461 is 7-5-4-3-2 offsuit; lower is stronger.
+uint16_t strengthClass(const uint8_t* cards, int count);
+
+HandType strengthClassType(uint16_t strengthClass);
+
+#endif  // STRENGTH_HPP
@@ -0,0 +1,52 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A unit of work split into independent chunks. The pool calls runChunk exactly once
+// for every index in [0, chunkCount()), possibly from several workers at once.
+class PoolTask {
+ public:
+  virtual ~PoolTask() = default;
+  virtual size_t chunkCount() const = 0;
+  virtual void runChunk(size_t chunk) = 0;
+};
+
+// Process-wide worker pool shared by every job. Queued tasks are served round-robin,
+// one chunk at a time, so a long job cannot starve the ones submitted after it.
+class ThreadPool {
+ public:
+  static ThreadPool& instance();
+
+  explicit ThreadPool(unsigned int numThreads);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  void submit(std::shared_ptr<PoolTask> task);
+  unsigned int size() const { return static_cast<unsigned int>(workers.size()); }
+
+ private:
+  struct Entry {
+    std::shared_ptr<PoolTask> task;
+    size_t nextChunk;
+    size_t chunkCount;
+  };
+
+  void workerLoop();
+
+  std::vector<std::thread> workers;
+  std::deque<Entry> queue;
+  std::mutex mutex;
+  std::condition_variable available;
+  bool stopping = false;
+};
+
+#endif  // THREAD_POOL_HPP
@@ -1,4 +1,6 @@
 #include "card.hpp"
+#include <cctype>
+#include <stdexcept>
 #include <string>
 
 // Get a string representation of the card
@@ -29,4 +31,29 @@ std::string Card::toString() const {
     }
 
     return rankStr + " of " + suitStr;
-}
\ No newline at end of file
+}
+
+namespace {
+const char RANK_CHARS[] = "23456789TJQKA";
+const char SUIT_CHARS[] = "hdcs";
+}  // namespace
+
+std::string Card::toShortString() const {
+    return std::string(1, RANK_CHARS[value >> 2]) + SUIT_CHARS[value & 0x3];
+}
+
+Card Card::fromString(const std::string& text) {
+    std::string rankText = text.substr(0, text.empty() ? 0 : text.size() - 1);
+    if (rankText == "10") rankText = "T";
+    if (rankText.size() != 1) throw std::runtime_error("Invalid card: " + text);
+
+    char rankChar = static_cast<char>(std::toupper(static_cast<unsigned char>(rankText[0])));
+    char suitChar = static_cast<char>(std::tolower(static_cast<unsigned char>(text.back())));
+    for (uint8_t r = 0; r < 13; ++r) {
+        if (RANK_CHARS[r] != rankChar) continue;
+        for (uint8_t s = 0; s < 4; ++s) {
+            if (SUIT_CHARS[s] == suitChar) return Card(static_cast<uint8_t>(r << 2 | s));
+        }
+    }
+    throw std::runtime_error("Invalid card: " + text);
+}
@@ -15,9 +15,11 @@ Deck::Deck() {
 void Deck::shuffle() {
   static std::random_device rd;
   static std::mt19937 g(rd());  // Keep generator static for better performance
-  std::shuffle(cards.begin(), cards.end(), g);
+  shuffle(g);
 }
 
+void Deck::shuffle(std::mt19937& g) { std::shuffle(cards.begin(), cards.end(), g); }
+
 Card Deck::dealCard() {
   // Deal a card from the top of the deck
   Card dealtCard = cards.back();
@@ -0,0 +1,337 @@
+#include "draw_solver.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <locale>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "card.hpp"
+#include "evaluator.hpp"
+
+namespace {
+
+const size_t HAND_TYPES = static_cast<size_t>(HandType::Count);
+const unsigned long long TOTAL_DEALT_HANDS = 2598960;  // C(52,5)
+
+using TypeCounts = std::array<uint32_t, HAND_TYPES>;
+
+struct Binomials {
+  uint32_t table[53][6];
+  Binomials() {
+    for (int n = 0; n <= 52; ++n) {
+      table[n][0] = 1;
+      for (int k = 1; k <= 5; ++k) table[n][k] = n == 0 ? 0 : table[n - 1][k - 1] + table[n - 1][k];
+    }
+  }
+};
+
+uint32_t choose(int n, int k) {
+  static const Binomials binomials;
+  return binomials.table[n][k];
+}
+
+// Combinatorial number system rank of an ascending card set
+uint32_t colexIndex(const uint8_t* sorted, int k) {
+  uint32_t index = 0;
+  for (int i = 0; i < k; ++i) index += choose(sorted[i], i + 1);
+  return index;
+}
+
+template <typename Fn>
+void forEachCombination(int k, Fn fn) {
+  uint8_t c[5];
+  for (int i = 0; i < k; ++i) c[i] = static_cast<uint8_t>(i);
+  for (;;) {
+    fn(c);
+    int i = k - 1;
+    while (i >= 0 && c[i] == 52 - k + i) --i;
+    if (i < 0) return;
+    ++c[i];
+    for (int j = i + 1; j < k; ++j) c[j] = static_cast<uint8_t>(c[j - 1] + 1);
+  }
+}
+
+HandType evaluate(const uint8_t* cards) {
+  EvalState state;
+  for (int i = 0; i < 5; ++i) state = state.add(cards[i]);
+  return state.handType();
+}
+
+// Suit relabelling that minimises the sorted encoding; hands sharing a key play identically
+struct Canonical {
+  uint32_t key;
+  uint8_t classSize;
+  std::array<uint8_t, 5> position;  // position[i]: slot of cards[i] in the canonical hand
+};
+
+const std::vector<std::array<uint8_t, 4>>& suitPermutations() {
+  static const std::vector<std::array<uint8_t, 4>> perms = [] {
+    std::vector<std::array<uint8_t, 4>> result;
+    std::array<uint8_t, 4> perm = {0, 1, 2, 3};
+    do {
+      result.push_back(perm);
+    } while (std::next_permutation(perm.begin(), perm.end()));
+    return result;
+  }();
+  return perms;
+}
+
+Canonical canonicalize(const std::array<uint8_t, 5>& cards) {
+  Canonical best{UINT32_MAX, 0, {}};
+  int stabilizer = 0;
+
+  for (const auto& perm : suitPermutations()) {
+    uint8_t mapped[5];
+    std::array<uint8_t, 5> order = {0, 1, 2, 3, 4};
+    for (int i = 0; i < 5; ++i) mapped[i] = static_cast<uint8_t>((cards[i] & ~0x3) | perm[cards[i] & 0x3]);
+    std::sort(order.begin(), order.end(), [&](uint8_t a, uint8_t b) { return mapped[a] < mapped[b]; });
+
+    uint32_t key = 0;
+    for (int j = 0; j < 5; ++j) key = key << 6 | mapped[order[j]];
+    if (key < best.key) {
+      best.key = key;
+      for (int j = 0; j < 5; ++j) best.position[order[j]] = static_cast<uint8_t>(j);
+      stabilizer = 1;
+    } else if (key == best.key) {
+      ++stabilizer;
+    }
+  }
+  best.classSize = static_cast<uint8_t>(24 / stabilizer);
+  return best;
+}
+
+// Converts a mask over sorted slots back to the caller's card order
+uint8_t slotsToCards(uint8_t mask, const std::array<uint8_t, 5>& position) {
+  uint8_t result = 0;
+  for (int i = 0; i < 5; ++i) {
+    if (mask & (1 << position[i])) result |= static_cast<uint8_t>(1 << i);
+  }
+  return result;
+}
+
+uint8_t cardsToSlots(uint8_t mask, const std::array<uint8_t, 5>& position) {
+  uint8_t result = 0;
+  for (int i = 0; i < 5; ++i) {
+    if (mask & (1 << i)) result |= static_cast<uint8_t>(1 << position[i]);
+  }
+  return result;
+}
+
+uint8_t bestDiscard(const std::array<DrawOutcome, 32>& byDiscard, const DrawPaytable& paytable) {
+  uint8_t best = 0;
+  double bestValue = byDiscard[0].expectedValue(paytable);
+  for (uint8_t discard = 1; discard < 32; ++discard) {
+    double value = byDiscard[discard].expectedValue(paytable);
+    if (value > bestValue) {
+      bestValue = value;
+      best = discard;
+    }
+  }
+  return best;
+}
+
+}  // namespace
+
+struct DrawSolver::SubsetCounts {
+  // bySize[k][colexIndex(S)]: hands among all C(52,5) containing the k-card set S, per HandType
+  std::array<std::vector<TypeCounts>, 5> bySize;
+
+  SubsetCounts() {
+    for (int k = 0; k < 5; ++k) bySize[k].assign(choose(52, k), TypeCounts{});
+
+    // Deal every hand once, extending the evaluator card by card, and credit its 4-card subsets
+    std::vector<TypeCounts>& quads = bySize[4];
+    const EvalState empty;
+    for (uint8_t a = 0; a < 52; ++a) {
+      EvalState sa = empty.add(a);
+      for (uint8_t b = a + 1; b < 52; ++b) {
+        EvalState sb = sa.add(b);
+        for (uint8_t c = b + 1; c < 52; ++c) {
+          EvalState sc = sb.add(c);
+          for (uint8_t d = c + 1; d < 52; ++d) {
+            EvalState sd = sc.add(d);
+            uint32_t abcd = colexIndex(std::array<uint8_t, 4>{{a, b, c, d}}.data(), 4);
+            for (uint8_t e = d + 1; e < 52; ++e) {
+              size_t type = static_cast<size_t>(sd.add(e).handType());
+              const uint8_t hand[5] = {a, b, c, d, e};
+              quads[abcd][type]++;
+              for (int skip = 0; skip < 4; ++skip) {
+                uint8_t subset[4];
+                for (int i = 0, j = 0; i < 5; ++i) {
+                  if (i != skip) subset[j++] = hand[i];
+                }
+                quads[colexIndex(subset, 4)][type]++;
+              }
+            }
+          }
+        }
+      }
+    }
+
+    // Each hand containing a k-set S contains 5 - k of its (k+1)-supersets
+    for (int k = 3; k >= 0; --k) {
+      std::vector<TypeCounts>& lower = bySize[k];
+      const std::vector<TypeCounts>& upper = bySize[k + 1];
+      forEachCombination(k + 1, [&](const uint8_t* superset) {
+        const TypeCounts& from = upper[colexIndex(superset, k + 1)];
+        for (int skip = 0; skip <= k; ++skip) {
+          uint8_t subset[4];
+          for (int i = 0, j = 0; i <= k; ++i) {
+            if (i != skip) subset[j++] = superset[i];
+          }
+          TypeCounts& to = lower[colexIndex(subset, k)];
+          for (size_t t = 0; t < HAND_TYPES; ++t) to[t] += from[t];
+        }
+      });
+      for (TypeCounts& entry : lower) {
+        for (uint32_t& count : entry) count /= 5 - k;
+      }
+    }
+  }
+
+  // Outcome per held-card mask of an ascending hand, from 32 table lookups
+  std::array<TypeCounts, 32> holdOutcomes(const uint8_t* sorted) const {
+    std::array<TypeCounts, 32> f;
+    for (uint8_t mask = 0; mask < 31; ++mask) {
+      uint8_t subset[4];
+      int k = 0;
+      for (int i = 0; i < 5; ++i) {
+        if (mask & (1 << i)) subset[k++] = sorted[i];
+      }
+      f[mask] = bySize[k][colexIndex(subset, k)];
+    }
+    f[31] = TypeCounts{};
+    f[31][static_cast<size_t>(evaluate(sorted))] = 1;
+
+    // Inclusion-exclusion over the cards not held: afterwards f[mask] only counts hands that
+    // contain none of the discarded cards, i.e. the draws from the remaining 47
+    for (int bit = 1; bit < 32; bit <<= 1) {
+      for (int mask = 0; mask < 32; ++mask) {
+        if (mask & bit) continue;
+        for (size_t t = 0; t < HAND_TYPES; ++t) f[mask][t] -= f[mask | bit][t];
+      }
+    }
+    return f;
+  }
+};
+
+const DrawPaytable& defaultDrawPaytable() {
+  static const DrawPaytable paytable = {800, 50, 25, 9, 6, 4, 3, 2, 1, 0};
+  return paytable;
+}
+
+uint32_t DrawOutcome::total() const {
+  uint32_t sum = 0;
+  for (uint32_t count : counts) sum += count;
+  return sum;
+}
+
+double DrawOutcome::expectedValue(const DrawPaytable& paytable) const {
+  double value = 0;
+  for (size_t t = 0; t < HAND_TYPES; ++t) value += counts[t] * paytable[t];
+  return value / total();
+}
+
+DrawChoice DrawTable::lookup(const std::array<uint8_t, 5>& cards) const {
+  Canonical canonical = canonicalize(cards);
+  DrawChoice choice = classes.at(canonical.key);
+  choice.discard = slotsToCards(choice.discard, canonical.position);
+  return choice;
+}
+
+double DrawTable::meanExpectedValue(const DrawPaytable& paytable) const {
+  double sum = 0;
+  for (const auto& entry : classes) sum += entry.second.classSize * entry.second.outcome.expectedValue(paytable);
+  return sum / TOTAL_DEALT_HANDS;
+}
+
+DrawSolver::DrawSolver(const DrawPaytable& paytable)
+    : paytable(paytable), counts(std::make_shared<const SubsetCounts>()) {}
+
+DrawAnalysis DrawSolver::analyze(const std::array<uint8_t, 5>& cards) const {
+  std::array<uint8_t, 5> order = {0, 1, 2, 3, 4};
+  std::sort(order.begin(), order.end(), [&](uint8_t a, uint8_t b) { return cards[a] < cards[b]; });
+
+  uint8_t sorted[5];
+  std::array<uint8_t, 5> position;
+  for (int j = 0; j < 5; ++j) {
+    sorted[j] = cards[order[j]];
+    position[order[j]] = static_cast<uint8_t>(j);
+    if (sorted[j] >= 52 || (j > 0 && sorted[j] == sorted[j - 1])) {
+      throw std::invalid_argument("Draw hands need five distinct cards");
+    }
+  }
+
+  std::array<TypeCounts, 32> held = counts->holdOutcomes(sorted);
+  DrawAnalysis analysis;
+  analysis.cards = cards;
+  for (uint8_t discard = 0; discard < 32; ++discard) {
+    analysis.byDiscard[discard].counts = held[31 ^ cardsToSlots(discard, position)];
+  }
+  analysis.bestDiscard = bestDiscard(analysis.byDiscard, paytable);
+  return analysis;
+}
+
+JobHandle<DrawTable> DrawSolver::submitFullTable(const JobOptions& options) const {
+  // One chunk per pair of lowest cards keeps chunks small enough to balance across workers
+  std::vector<std::pair<uint8_t, uint8_t>> prefixes;
+  for (uint8_t a = 0; a < 48; ++a) {
+    for (uint8_t b = a + 1; b < 49; ++b) prefixes.emplace_back(a, b);
+  }
+
+  std::shared_ptr<const SubsetCounts> tables = counts;
+  DrawPaytable pays = paytable;
+  return submitJob<DrawTable>(
+      prefixes.size(), TOTAL_DEALT_HANDS,
+      [tables, pays, prefixes](size_t chunk, DrawTable& local, JobControl& control) {
+        std::array<uint8_t, 5> hand = {prefixes[chunk].first, prefixes[chunk].second, 0, 0, 0};
+        unsigned long long dealt = 0;
+        for (hand[2] = hand[1] + 1; hand[2] < 52; ++hand[2]) {
+          for (hand[3] = hand[2] + 1; hand[3] < 52; ++hand[3]) {
+            for (hand[4] = hand[3] + 1; hand[4] < 52; ++hand[4]) {
+              // Solve each class once, at its canonical member
+              Canonical canonical = canonicalize(hand);
+              uint32_t key = 0;
+              for (uint8_t card : hand) key = key << 6 | card;
+              if (key != canonical.key) continue;
+
+              std::array<TypeCounts, 32> held = tables->holdOutcomes(hand.data());
+              std::array<DrawOutcome, 32> byDiscard;
+              for (uint8_t discard = 0; discard < 32; ++discard) byDiscard[discard].counts = held[31 ^ discard];
+
+              DrawChoice& choice = local.classes[key];
+              choice.discard = bestDiscard(byDiscard, pays);
+              choice.classSize = canonical.classSize;
+              choice.outcome = byDiscard[choice.discard];
+            }
+            dealt += 51 - hand[3];
+          }
+          if (control.stopRequested()) return;
+        }
+        control.addProgress(dealt);
+      },
+      options);
+}
+
+void DrawSolver::writeTable(const DrawTable& table, std::ostream& out) const {
+  std::locale previous = out.imbue(std::locale::classic());  // No grouping or decimal commas in the table
+  out << "# hand\tdiscard\tev";
+  for (size_t t = 0; t < HAND_TYPES; ++t) out << "\t" << Hand::getHandTypeName(static_cast<HandType>(t));
+  out << "\n" << std::fixed << std::setprecision(6);
+
+  std::array<uint8_t, 5> hand;
+  forEachCombination(5, [&](const uint8_t* cards) {
+    std::copy(cards, cards + 5, hand.begin());
+    DrawChoice choice = table.lookup(hand);
+
+    std::string discarded;
+    for (int i = 0; i < 5; ++i) {
+      out << (i > 0 ? " " : "") << Card(hand[i]).toShortString();
+      if (choice.discard & (1 << i)) discarded += (discarded.empty() ? "" : " ") + Card(hand[i]).toShortString();
+    }
+    out << "\t" << (discarded.empty() ? "-" : discarded) << "\t" << choice.outcome.expectedValue(paytable);
+    for (uint32_t count : choice.outcome.counts) out << "\t" << count;
+    out << "\n";
+  });
+  out.imbue(previous);
+}
@@ -0,0 +1,167 @@
+#include "hand_stream.hpp"
+#include <algorithm>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char MAGIC[4] = {'P', 'P', 'H', 'S'};
+const uint32_t FORMAT_VERSION = 1;
+
+template <typename T>
+void putLE(unsigned char* out, T value) {
+  for (size_t i = 0; i < sizeof(T); ++i) out[i] = static_cast<unsigned char>(value >> (8 * i));
+}
+
+template <typename T>
+T getLE(const unsigned char* in) {
+  T value = 0;
+  for (size_t i = 0; i < sizeof(T); ++i) value |= static_cast<T>(in[i]) << (8 * i);
+  return value;
+}
+
+}  // namespace
+
+HandBlock::HandBlock(int cardsPerHand, uint32_t handsPerBlock)
+    : bitsPerHand(6 * cardsPerHand), words(bytesPerBlock(cardsPerHand, handsPerBlock) / sizeof(uint64_t)) {}
+
+size_t HandBlock::bytesPerBlock(int cardsPerHand, uint32_t handsPerBlock) {
+  size_t bits = static_cast<size_t>(handsPerBlock) * 6 * cardsPerHand;
+  return ((bits + 63) / 64 + 1) * sizeof(uint64_t);  // Plus the spare word
+}
+
+void HandBlock::add(const uint8_t* cards) {
+  uint64_t bits = 0;
+  for (unsigned c = 0; c < bitsPerHand / 6; ++c) bits |= static_cast<uint64_t>(cards[c]) << (6 * c);
+
+  size_t bit = count++ * bitsPerHand;
+  size_t word = bit >> 6, offset = bit & 63;
+  words[word] |= bits << offset;
+  if (offset + bitsPerHand > 64) words[word + 1] |= bits >> (64 - offset);
+}
+
+HandStreamWriter::HandStreamWriter(const std::string& path, int cardsPerHand, unsigned long long totalHands,
+                                   uint32_t handsPerBlock)
+    : out(path, std::ios::binary | std::ios::trunc),
+      path(path),
+      cardsPerHand(cardsPerHand),
+      handsPerBlock(handsPerBlock),
+      totalHands(totalHands),
+      blockCount(static_cast<size_t>((totalHands + handsPerBlock - 1) / handsPerBlock)),
+      blockBytes(HandBlock::bytesPerBlock(cardsPerHand, handsPerBlock)) {
+  if (!out) throw std::runtime_error("Cannot open " + path);
+
+  // A zeroed placeholder until the last block lands, so HandStream rejects an unfinished recording
+  const unsigned char placeholder[HAND_STREAM_HEADER_SIZE] = {};
+  out.write(reinterpret_cast<const char*>(placeholder), sizeof(placeholder));
+  if (blockCount == 0) writeHeader();
+  out.flush();
+}
+
+void HandStreamWriter::write(size_t block, const HandBlock& hands) {
+  std::lock_guard<std::mutex> lock(mutex);
+  out.seekp(static_cast<std::streamoff>(HAND_STREAM_HEADER_SIZE + block * blockBytes));
+  out.write(reinterpret_cast<const char*>(hands.getWords().data()), static_cast<std::streamsize>(blockBytes));
+  if (++blocksWritten == blockCount) writeHeader();
+  out.flush();  // The file is complete as soon as the job is, even while this writer lives on
+  if (!out) throw std::runtime_error("Failed to write " + path);
+}
+
+void HandStreamWriter::writeHeader() {
+  unsigned char header[HAND_STREAM_HEADER_SIZE] = {};
+  std::memcpy(header, MAGIC, sizeof(MAGIC));
+  putLE<uint32_t>(header + 4, FORMAT_VERSION);
+  putLE<uint32_t>(header + 8, static_cast<uint32_t>(cardsPerHand));
+  putLE<uint32_t>(header + 12, handsPerBlock);
+  putLE<uint64_t>(header + 16, totalHands);
+  putLE<uint64_t>(header + 24, blockCount);
+  putLE<uint64_t>(header + 32, blockBytes);
+  out.seekp(0);
+  out.write(reinterpret_cast<const char*>(header), sizeof(header));
+}
+
+HandStream::HandStream(const std::string& path) : path(path) {
+#ifdef _WIN32
+  fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                           FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (fileHandle == INVALID_HANDLE_VALUE) throw std::runtime_error("Cannot open " + path);
+  LARGE_INTEGER fileSize;
+  GetFileSizeEx(fileHandle, &fileSize);
+  size = static_cast<size_t>(fileSize.QuadPart);
+  mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (mappingHandle) data = static_cast<const unsigned char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+  if (!data) {
+    if (mappingHandle) CloseHandle(mappingHandle);
+    CloseHandle(fileHandle);
+    throw std::runtime_error("Cannot map " + path);
+  }
+#else
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) throw std::runtime_error("Cannot open " + path);
+  struct stat info;
+  if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(HAND_STREAM_HEADER_SIZE)) {
+    close(fd);
+    throw std::runtime_error(path + " is not a hand stream");
+  }
+  size = static_cast<size_t>(info.st_size);
+  void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);  // The mapping keeps the file open
+  if (mapped == MAP_FAILED) throw std::runtime_error("Cannot map " + path);
+  madvise(mapped, size, MADV_WILLNEED);
+  data = static_cast<const unsigned char*>(mapped);
+#endif
+
+  // HandStreamWriter's placeholder header outlives a recording that was cancelled or timed out
+  if (size >= HAND_STREAM_HEADER_SIZE &&
+      std::all_of(data, data + HAND_STREAM_HEADER_SIZE, [](unsigned char byte) { return byte == 0; })) {
+    unmap();
+    throw std::runtime_error(path + " is an incomplete recording");
+  }
+  if (size < HAND_STREAM_HEADER_SIZE || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0 ||
+      getLE<uint32_t>(data + 4) != FORMAT_VERSION) {
+    unmap();
+    throw std::runtime_error(path + " is not a hand stream");
+  }
+  cardsPerHand = static_cast<int>(getLE<uint32_t>(data + 8));
+  handsPerBlock = getLE<uint32_t>(data + 12);
+  totalHands = getLE<uint64_t>(data + 16);
+  blockCount = static_cast<size_t>(getLE<uint64_t>(data + 24));
+  blockBytes = static_cast<size_t>(getLE<uint64_t>(data + 32));
+
+  // Bound blockCount by what the mapping holds before multiplying, so a crafted header cannot overflow the check
+  bool valid = cardsPerHand >= 5 && cardsPerHand <= 7 && handsPerBlock > 0 &&
+               blockCount == totalHands / handsPerBlock + (totalHands % handsPerBlock != 0) &&
+               blockBytes == HandBlock::bytesPerBlock(cardsPerHand, handsPerBlock) &&
+               blockCount <= (size - HAND_STREAM_HEADER_SIZE) / blockBytes;
+  if (!valid) {
+    unmap();
+    throw std::runtime_error(path + " has an invalid or truncated header");
+  }
+}
+
+HandStream::~HandStream() { unmap(); }
+
+void HandStream::unmap() {
+  if (!data) return;
+#ifdef _WIN32
+  UnmapViewOfFile(data);
+  CloseHandle(mappingHandle);
+  CloseHandle(fileHandle);
+#else
+  munmap(const_cast<unsigned char*>(data), size);
+#endif
+  data = nullptr;
+}
+
+size_t HandStream::handsInBlock(size_t block) const {
+  unsigned long long first = static_cast<unsigned long long>(block) * handsPerBlock;
+  return static_cast<size_t>(std::min<unsigned long long>(handsPerBlock, totalHands - first));
+}
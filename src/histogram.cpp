@@ -0,0 +1,95 @@
+#include "histogram.hpp"
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+
+const char MAGIC[4] = {'P', 'P', 'S', 'H'};
+const uint32_t FORMAT_VERSION = 1;
+
+template <typename T>
+void writeLE(std::ostream& out, T value) {
+  unsigned char bytes[sizeof(T)];
+  for (size_t i = 0; i < sizeof(T); ++i) bytes[i] = static_cast<unsigned char>(value >> (8 * i));
+  out.write(reinterpret_cast<const char*>(bytes), sizeof(T));
+}
+
+template <typename T>
+T readLE(std::istream& in) {
+  unsigned char bytes[sizeof(T)];
+  if (!in.read(reinterpret_cast<char*>(bytes), sizeof(T))) throw std::runtime_error("Truncated histogram file");
+  T value = 0;
+  for (size_t i = 0; i < sizeof(T); ++i) value |= static_cast<T>(bytes[i]) << (8 * i);
+  return value;
+}
+
+}  // namespace
+
+void StrengthHistogram::merge(const StrengthChunkCounts& chunk) {
+  for (size_t i = 0; i < NUM_STRENGTH_CLASSES; ++i) counts[i] += chunk.counts[i];
+}
+
+void StrengthHistogram::merge(const StrengthHistogram& other) {
+  if (other.cardsPerHand != cardsPerHand) {
+    throw std::runtime_error("Cannot merge histograms of " + std::to_string(cardsPerHand) + "- and " +
+                             std::to_string(other.cardsPerHand) + "-card hands");
+  }
+  for (size_t i = 0; i < NUM_STRENGTH_CLASSES; ++i) counts[i] += other.counts[i];
+}
+
+unsigned long long StrengthHistogram::total() const {
+  unsigned long long sum = 0;
+  for (unsigned long long count : counts) sum += count;
+  return sum;
+}
+
+std::vector<double> StrengthHistogram::cumulative() const {
+  std::vector<double> result(NUM_STRENGTH_CLASSES);
+  unsigned long long all = total();
+  unsigned long long running = 0;
+  for (size_t i = 0; i < NUM_STRENGTH_CLASSES; ++i) {
+    running += counts[i];
+    result[i] = all > 0 ? static_cast<double>(running) / all : 0.0;
+  }
+  return result;
+}
+
+std::array<unsigned long long, static_cast<size_t>(HandType::Count)> StrengthHistogram::byHandType() const {
+  std::array<unsigned long long, static_cast<size_t>(HandType::Count)> result{};
+  for (size_t i = 0; i < NUM_STRENGTH_CLASSES; ++i) {
+    result[static_cast<size_t>(strengthClassType(static_cast<uint16_t>(i)))] += counts[i];
+  }
+  return result;
+}
+
+void StrengthHistogram::save(const std::string& path) const {
+  std::ofstream out(path, std::ios::binary);
+  if (!out) throw std::runtime_error("Cannot open " + path);
+  out.write(MAGIC, sizeof(MAGIC));
+  writeLE<uint32_t>(out, FORMAT_VERSION);
+  writeLE<uint32_t>(out, static_cast<uint32_t>(cardsPerHand));
+  writeLE<uint32_t>(out, static_cast<uint32_t>(NUM_STRENGTH_CLASSES));
+  for (unsigned long long count : counts) writeLE<uint64_t>(out, count);
+  if (!out) throw std::runtime_error("Failed to write " + path);
+}
+
+StrengthHistogram StrengthHistogram::load(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) throw std::runtime_error("Cannot open " + path);
+
+  char magic[sizeof(MAGIC)];
+  if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+    throw std::runtime_error(path + " is not a strength histogram");
+  }
+  if (readLE<uint32_t>(in) != FORMAT_VERSION) throw std::runtime_error(path + " has an unsupported version");
+
+  uint32_t cardsPerHand = readLE<uint32_t>(in);
+  if (cardsPerHand < 5 || cardsPerHand > 7) throw std::runtime_error(path + " has an invalid hand size");
+  if (readLE<uint32_t>(in) != NUM_STRENGTH_CLASSES) throw std::runtime_error(path + " has the wrong class count");
+
+  StrengthHistogram histogram(static_cast<int>(cardsPerHand));
+  for (unsigned long long& count : histogram.counts) count = readLE<uint64_t>(in);
+  if (in.peek() != std::ifstream::traits_type::eof()) throw std::runtime_error(path + " has trailing data");
+  return histogram;
+}
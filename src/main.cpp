@@ -1,14 +1,24 @@
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <limits>
+#include <locale>
+#include <memory>
 #include <sstream>  // Add this include for stringstream
 #include <string>
 #include <thread>
 #include <vector>
 #include "cuda_probability.cuh"
 #include "deck.hpp"
+#include "draw_solver.hpp"
 #include "hand.hpp"
+#include "hand_stream.hpp"
+#include "histogram.hpp"
 #include "probability.hpp"
+#include "probability_jobs.hpp"
 #include "utils.hpp"
 
 void printUsage(const char* programName) {
@@ -25,6 +35,17 @@ void printUsage(const char* programName) {
             << "                 fl (Flush), st (Straight), 3k (Three of a Kind),\n"
             << "                 2p (Two Pair), 1p (One Pair), hc (High Card)\n"
             << "  -n NUMBER      Number of hands to simulate (default: 100000000)\n"
+            << "  -e, --enumerate  Count every possible hand exactly instead of simulating (CPU only)\n"
+            << "  --timeout SECS   Abort the CPU job if it runs longer than SECS seconds\n"
+            << "  --record FILE    Also write every simulated hand to FILE (CPU only)\n"
+            << "  --replay FILE    Evaluate the hands recorded in FILE instead of dealing new ones\n"
+            << "  --draw CARDS     Five-card draw: expected outcome of every discard, e.g. --draw \"Ah Kh Qh Jh 2c\"\n"
+            << "  --draw-table FILE  Five-card draw: optimal discard for all 2,598,960 hands, written to FILE\n"
+            << "  -s, --strength   Histogram over all 7462 hand-strength classes (honours -n, -e)\n"
+            << "  --cards N        Cards per hand for --strength: 5, 6 or 7 (default: 5)\n"
+            << "  --save FILE      Save the --strength histogram to a binary file\n"
+            << "  --load FILE      Merge a saved histogram; repeatable. Without -n or -e nothing new is run\n"
+            << "  --csv FILE       Write per-class counts and cumulative distribution as CSV\n"
             << std::endl;
 }
 
@@ -58,6 +79,44 @@ void printProgress(float progress) {
   std::cout.flush();
 }
 
+// Polls a running job, drawing the progress bar until it finishes
+template <typename Result>
+Result waitWithProgress(const JobHandle<Result>& job) {
+  while (!job.waitFor(std::chrono::milliseconds(100))) {
+    printProgress(static_cast<float>(job.progress()));
+  }
+  const Result& results = job.get();
+  printProgress(1.0f);
+  std::cout << std::endl;
+  return results;
+}
+
+// Where CPU jobs get their hands from
+struct HandSource {
+  bool enumerate = false;
+  std::string recordPath;
+  std::shared_ptr<const HandStream> replay;
+};
+
+HandTypeCounts runCpu(int totalHands, const HandSource& source, const JobOptions& options) {
+  if (source.replay) return waitWithProgress(submitReplay(source.replay, options));
+  if (source.enumerate) return waitWithProgress(submitEnumeration(options));
+  return waitWithProgress(submitSimulation(totalHands, options, source.recordPath));
+}
+
+std::array<uint8_t, 5> parseDrawHand(const std::string& text) {
+  std::array<uint8_t, 5> cards;
+  std::stringstream ss(text);
+  std::string token;
+  size_t count = 0;
+  while (ss >> token) {
+    if (count == cards.size()) throw std::runtime_error("Draw hands have exactly five cards: " + text);
+    cards[count++] = Card::fromString(token).getValue();
+  }
+  if (count != cards.size()) throw std::runtime_error("Draw hands have exactly five cards: " + text);
+  return cards;
+}
+
 std::string formatNumber(unsigned long long num) {
     std::stringstream ss;
     ss.imbue(std::locale(""));
@@ -113,6 +172,146 @@ void runAndPrintAllResults(bool isCuda, int handsToSimulate, double elapsed, con
     std::cout << std::string(80, '=') << "\n";
 }
 
+std::string describeDiscard(const std::array<uint8_t, 5>& cards, uint8_t discard) {
+  std::string result;
+  for (size_t i = 0; i < cards.size(); ++i) {
+    if (discard & (1 << i)) result += (result.empty() ? "" : " ") + Card(cards[i]).toShortString();
+  }
+  return result.empty() ? "none" : result;
+}
+
+void printDrawAnalysis(const DrawAnalysis& analysis, const DrawPaytable& paytable) {
+  std::array<uint8_t, 32> order;
+  for (uint8_t i = 0; i < 32; ++i) order[i] = i;
+  std::sort(order.begin(), order.end(), [&](uint8_t a, uint8_t b) {
+    return analysis.byDiscard[a].expectedValue(paytable) > analysis.byDiscard[b].expectedValue(paytable);
+  });
+
+  std::cout << "\nDraw Analysis:\n" << std::string(50, '=') << "\n";
+  std::cout << std::left << std::setw(20) << "Discard" << std::right << std::setw(15) << "Draws" << std::setw(15)
+            << "EV" << "\n";
+  std::cout << std::string(50, '-') << "\n";
+  for (uint8_t discard : order) {
+    const DrawOutcome& outcome = analysis.byDiscard[discard];
+    std::cout << std::left << std::setw(20) << describeDiscard(analysis.cards, discard) << std::right << std::setw(15)
+              << formatNumber(outcome.total()) << std::fixed << std::setprecision(4) << std::setw(15)
+              << outcome.expectedValue(paytable) << "\n";
+  }
+
+  const DrawOutcome& best = analysis.byDiscard[analysis.bestDiscard];
+  std::cout << std::string(50, '-') << "\n"
+            << "Best discard: " << describeDiscard(analysis.cards, analysis.bestDiscard) << "\n";
+  for (int t = 0; t < static_cast<int>(HandType::Count); ++t) {
+    std::cout << std::left << std::setw(20) << Hand::getHandTypeName(static_cast<HandType>(t)) << std::right
+              << std::setw(15) << formatNumber(best.counts[t]) << std::fixed << std::setprecision(4)
+              << std::setw(14) << (100.0 * best.counts[t] / best.total()) << "%\n";
+  }
+  std::cout << std::string(50, '=') << "\n";
+}
+
+int runDraw(const std::string& hand, const std::string& tablePath, const JobOptions& options) {
+  auto start = std::chrono::high_resolution_clock::now();
+  DrawSolver solver;
+
+  if (!hand.empty()) {
+    printDrawAnalysis(solver.analyze(parseDrawHand(hand)), solver.getPaytable());
+  } else {
+    std::ofstream out(tablePath);
+    if (!out) throw std::runtime_error("Cannot open " + tablePath);
+    std::cout << "Solving all 2,598,960 draw hands...\n";
+    DrawTable table = waitWithProgress(solver.submitFullTable(options));
+    solver.writeTable(table, out);
+    std::cout << "Classes: " << formatNumber(table.classes.size()) << "\n"
+              << "Mean EV with optimal discards: " << std::fixed << std::setprecision(6)
+              << table.meanExpectedValue(solver.getPaytable()) << "\n"
+              << "Table written to " << tablePath << "\n";
+  }
+
+  auto end = std::chrono::high_resolution_clock::now();
+  std::cout << "Time: " << std::fixed << std::setprecision(2) << std::chrono::duration<double>(end - start).count()
+            << "s\n";
+  return 0;
+}
+
+struct StrengthOptions {
+  int cardsPerHand = 5;
+  bool run = true;
+  std::vector<std::string> loadPaths;
+  std::string savePath, csvPath;
+};
+
+void writeStrengthCsv(const StrengthHistogram& histogram, const std::string& path) {
+  std::ofstream out(path);
+  if (!out) throw std::runtime_error("Cannot open " + path);
+  out.imbue(std::locale::classic());  // main() installs the user's locale, which would group digits
+  std::vector<double> cumulative = histogram.cumulative();
+  unsigned long long total = histogram.total();
+
+  out << "class,hand_type,count,probability,cumulative\n" << std::setprecision(10);
+  for (size_t i = 0; i < NUM_STRENGTH_CLASSES; ++i) {
+    out << i << "," << Hand::getHandTypeName(strengthClassType(static_cast<uint16_t>(i))) << ","
+        << histogram.counts[i] << "," << (total > 0 ? static_cast<double>(histogram.counts[i]) / total : 0.0) << ","
+        << cumulative[i] << "\n";
+  }
+}
+
+void printStrengthSummary(const StrengthHistogram& histogram, double elapsed) {
+  auto byType = histogram.byHandType();
+  unsigned long long total = histogram.total();
+  size_t classesSeen = 0;
+  for (unsigned long long count : histogram.counts) classesSeen += count > 0;
+
+  std::cout << "\nStrength Histogram (" << histogram.cardsPerHand << "-card hands):\n";
+  std::cout << std::string(80, '=') << "\n";
+  std::cout << std::left << std::setw(16) << "Hand Type" << std::right << std::setw(18) << "Count" << std::setw(14)
+            << "Probability" << std::setw(14) << "Cumulative" << "\n";
+  std::cout << std::string(80, '-') << "\n";
+
+  unsigned long long running = 0;
+  for (int t = 0; t < static_cast<int>(HandType::Count); ++t) {
+    running += byType[t];
+    double share = total > 0 ? 100.0 * byType[t] / total : 0.0;
+    double cumulative = total > 0 ? 100.0 * running / total : 0.0;
+    std::cout << std::left << std::setw(16) << Hand::getHandTypeName(static_cast<HandType>(t)) << std::right
+              << std::setw(18) << formatNumber(byType[t]) << std::fixed << std::setprecision(4) << std::setw(13)
+              << share << "%" << std::setw(13) << cumulative << "%\n";
+  }
+
+  std::cout << std::string(80, '-') << "\n";
+  std::cout << std::left << std::setw(16) << "Total:" << std::right << std::setw(18) << formatNumber(total)
+            << "\nClasses seen: " << classesSeen << " of " << NUM_STRENGTH_CLASSES << "\nTime: " << std::fixed
+            << std::setprecision(2) << elapsed << "s\n";
+  std::cout << std::string(80, '=') << "\n";
+}
+
+int runStrength(int totalHands, const HandSource& source, const StrengthOptions& strength, const JobOptions& options) {
+  auto start = std::chrono::high_resolution_clock::now();
+  StrengthHistogram histogram(strength.cardsPerHand);
+
+  // Without a new run the first saved histogram decides the hand size
+  size_t firstMerge = 0;
+  if (!strength.run) histogram = StrengthHistogram::load(strength.loadPaths[firstMerge++]);
+  for (size_t i = firstMerge; i < strength.loadPaths.size(); ++i) {
+    histogram.merge(StrengthHistogram::load(strength.loadPaths[i]));
+  }
+  if (strength.run) {
+    if (source.replay) {
+      histogram.merge(waitWithProgress(submitStrengthReplay(source.replay, options)));
+    } else if (source.enumerate) {
+      histogram.merge(waitWithProgress(submitStrengthEnumeration(strength.cardsPerHand, options)));
+    } else {
+      histogram.merge(waitWithProgress(
+          submitStrengthSimulation(totalHands, strength.cardsPerHand, options, source.recordPath)));
+    }
+  }
+
+  auto end = std::chrono::high_resolution_clock::now();
+  printStrengthSummary(histogram, std::chrono::duration<double>(end - start).count());
+  if (!strength.savePath.empty()) histogram.save(strength.savePath);
+  if (!strength.csvPath.empty()) writeStrengthCsv(histogram, strength.csvPath);
+  return 0;
+}
+
 int main(int argc, char* argv[]) {
   std::locale::global(std::locale(""));
   std::cout.imbue(std::locale(""));
@@ -123,6 +322,14 @@ int main(int argc, char* argv[]) {
   int totalHands = 100'000'000;
   HandType targetType = HandType::ThreeOfAKind;
   bool typeSpecified = false;  // New flag to track if -t was used
+  HandSource source;
+  std::string replayPath;
+  JobOptions jobOptions;
+  bool timeoutSpecified = false;
+  std::string drawHand, drawTablePath;
+  bool strengthMode = false;
+  bool handsSpecified = false;
+  StrengthOptions strength;
 
   // Parse command line arguments
   for (int i = 1; i < argc; i++) {
@@ -151,7 +358,41 @@ int main(int argc, char* argv[]) {
     } else if (arg == "-a" || arg == "--all") {
       allTypes = true;
       typeSpecified = false;
+    } else if (arg == "-e" || arg == "--enumerate") {
+      source.enumerate = true;
+    } else if (arg == "--timeout" && i + 1 < argc) {
+      double seconds = std::stod(argv[++i]);
+      if (seconds <= 0) {
+        std::cerr << "Error: Timeout must be positive\n";
+        return 1;
+      }
+      timeoutSpecified = true;
+      jobOptions = JobOptions::withTimeout(
+          std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds)));
+    } else if (arg == "--record" && i + 1 < argc) {
+      source.recordPath = argv[++i];
+    } else if (arg == "--replay" && i + 1 < argc) {
+      replayPath = argv[++i];
+    } else if (arg == "--draw" && i + 1 < argc) {
+      drawHand = argv[++i];
+    } else if (arg == "--draw-table" && i + 1 < argc) {
+      drawTablePath = argv[++i];
+    } else if (arg == "-s" || arg == "--strength") {
+      strengthMode = true;
+    } else if (arg == "--cards" && i + 1 < argc) {
+      strength.cardsPerHand = std::stoi(argv[++i]);
+      if (strength.cardsPerHand < 5 || strength.cardsPerHand > 7) {
+        std::cerr << "Error: Cards per hand must be 5, 6 or 7\n";
+        return 1;
+      }
+    } else if (arg == "--save" && i + 1 < argc) {
+      strength.savePath = argv[++i];
+    } else if (arg == "--load" && i + 1 < argc) {
+      strength.loadPaths.push_back(argv[++i]);
+    } else if (arg == "--csv" && i + 1 < argc) {
+      strength.csvPath = argv[++i];
     } else if (arg == "-n" && i + 1 < argc) {
+      handsSpecified = true;
       totalHands = std::stoi(argv[++i]);
       if (totalHands <= 0) {
         std::cerr << "Error: Number of hands must be positive\n";
@@ -164,6 +405,80 @@ int main(int argc, char* argv[]) {
     }
   }
 
+  if (!drawHand.empty() || !drawTablePath.empty()) {
+    if (!drawHand.empty() && !drawTablePath.empty()) {
+      std::cerr << "Error: Use either --draw or --draw-table, not both\n";
+      return 1;
+    }
+    if (useCuda || benchmark) {
+      std::cerr << "Error: The draw solver is only available on the CPU\n";
+      return 1;
+    }
+    try {
+      return runDraw(drawHand, drawTablePath, jobOptions);
+    } catch (const std::exception& e) {
+      std::cerr << "\nError: " << e.what() << "\n";
+      return 1;
+    }
+  }
+
+  if (!source.recordPath.empty() || !replayPath.empty()) {
+    int sources = !source.recordPath.empty() + !replayPath.empty() + source.enumerate;
+    if (sources > 1 || useCuda || benchmark) {
+      std::cerr << "Error: --record and --replay need a plain CPU simulation\n";
+      return 1;
+    }
+  }
+  if (!replayPath.empty()) {
+    try {
+      source.replay = std::make_shared<const HandStream>(replayPath);
+    } catch (const std::exception& e) {
+      std::cerr << "Error: " << e.what() << "\n";
+      return 1;
+    }
+    if (!strengthMode && source.replay->getCardsPerHand() != 5) {
+      std::cerr << "Error: " << replayPath << " holds " << source.replay->getCardsPerHand()
+                << "-card hands; replay it with --strength\n";
+      return 1;
+    }
+    if (source.replay->getTotalHands() > static_cast<unsigned long long>(std::numeric_limits<int>::max())) {
+      std::cerr << "Error: " << replayPath << " holds more hands than a single run supports\n";
+      return 1;
+    }
+    totalHands = static_cast<int>(source.replay->getTotalHands());
+    strength.cardsPerHand = source.replay->getCardsPerHand();
+  }
+
+  if (strengthMode) {
+    if (useCuda || benchmark) {
+      std::cerr << "Error: Strength histograms are only available on the CPU\n";
+      return 1;
+    }
+    strength.run = strength.loadPaths.empty() || handsSpecified || source.enumerate || source.replay;
+    if (!strength.run && !source.recordPath.empty()) {
+      std::cerr << "Error: --record needs a simulation; pass -n along with --load\n";
+      return 1;
+    }
+    try {
+      return runStrength(totalHands, source, strength, jobOptions);
+    } catch (const std::exception& e) {
+      std::cerr << "\nError: " << e.what() << "\n";
+      return 1;
+    }
+  }
+
+  if (source.enumerate) {
+    if (useCuda || benchmark) {
+      std::cerr << "Error: Enumeration is only available on the CPU\n";
+      return 1;
+    }
+    totalHands = 2598960;  // C(52,5)
+  }
+  if (timeoutSpecified && (useCuda || benchmark)) {
+    std::cerr << "Error: --timeout only applies to the CPU implementation\n";
+    return 1;
+  }
+
   std::cout << "Starting poker probability simulation...\n";
   if (!allTypes) {
     std::cout << "Hand type: " << Hand::getHandTypeName(targetType) << "\n";
@@ -177,67 +492,73 @@ int main(int argc, char* argv[]) {
   double cpuProb = 0, cudaProb = 0;
   double cpuTime = 0, cudaTime = 0;
 
-  if (allTypes) {
-    if (benchmark) {
-      std::cout << "\nRunning CPU implementation...\n";
-      auto cpuStart = std::chrono::high_resolution_clock::now();
-      HandTypeCounts cpuResults = calculateAllProbabilities(totalHands);
-      auto cpuEnd = std::chrono::high_resolution_clock::now();
-      double cpuElapsed = std::chrono::duration<double>(cpuEnd - cpuStart).count();
-      runAndPrintAllResults(false, totalHands, cpuElapsed, cpuResults);
-
-      std::cout << "\nRunning CUDA implementation...\n";
-      auto cudaStart = std::chrono::high_resolution_clock::now();
-      HandTypeCounts cudaResults = calculateAllProbabilitiesCUDA(totalHands);
-      auto cudaEnd = std::chrono::high_resolution_clock::now();
-      double cudaElapsed = std::chrono::duration<double>(cudaEnd - cudaStart).count();
-      runAndPrintAllResults(true, totalHands, cudaElapsed, cudaResults);
-
-      // Print speedup comparison
-      double speedup = cpuElapsed / cudaElapsed;
-      std::cout << "\nPerformance Comparison:\n"
-                << "----------------\n"
-                << "CPU Time: " << std::fixed << std::setprecision(2) << cpuElapsed << "s\n"
-                << "GPU Time: " << std::fixed << std::setprecision(2) << cudaElapsed << "s\n"
-                << "CUDA Speedup: " << std::fixed << std::setprecision(2) << speedup << "x\n";
-    } else {
-      auto start = std::chrono::high_resolution_clock::now();
-      HandTypeCounts results = useCuda ? calculateAllProbabilitiesCUDA(totalHands) : calculateAllProbabilities(totalHands);
-      auto end = std::chrono::high_resolution_clock::now();
-      double elapsed = std::chrono::duration<double>(end - start).count();
-      runAndPrintAllResults(useCuda, totalHands, elapsed, results);
-    }
-  } else {
-    if (benchmark) {
-      // CPU implementation
-      std::cout << "\nRunning CPU implementation...\n";
-      auto start = std::chrono::high_resolution_clock::now();
-      HandTypeCounts cpuResults = calculateAllProbabilities(totalHands);
-      auto end = std::chrono::high_resolution_clock::now();
-      auto cpuElapsed = std::chrono::duration<double>(end - start).count();
-      runAndPrintResults(false, targetType, cpuResults, cpuElapsed, totalHands);
-
-      // CUDA implementation
-      std::cout << "\nRunning CUDA implementation...\n";
-      start = std::chrono::high_resolution_clock::now();
-      HandTypeCounts cudaResults = calculateAllProbabilitiesCUDA(totalHands);
-      end = std::chrono::high_resolution_clock::now();
-      auto cudaElapsed = std::chrono::duration<double>(end - start).count();
-      runAndPrintResults(true, targetType, cudaResults, cudaElapsed, totalHands);
-
-      // Print speedup comparison
-      double speedup = cpuElapsed / cudaElapsed;
-      std::cout << "\nPerformance Comparison:\n"
-                << "----------------\n"
-                << "CUDA Speedup: " << std::fixed << std::setprecision(2) << speedup << "x\n";
+  try {
+    if (allTypes) {
+      if (benchmark) {
+        std::cout << "\nRunning CPU implementation...\n";
+        auto cpuStart = std::chrono::high_resolution_clock::now();
+        HandTypeCounts cpuResults = runCpu(totalHands, source, jobOptions);
+        auto cpuEnd = std::chrono::high_resolution_clock::now();
+        double cpuElapsed = std::chrono::duration<double>(cpuEnd - cpuStart).count();
+        runAndPrintAllResults(false, totalHands, cpuElapsed, cpuResults);
+
+        std::cout << "\nRunning CUDA implementation...\n";
+        auto cudaStart = std::chrono::high_resolution_clock::now();
+        HandTypeCounts cudaResults = calculateAllProbabilitiesCUDA(totalHands);
+        auto cudaEnd = std::chrono::high_resolution_clock::now();
+        double cudaElapsed = std::chrono::duration<double>(cudaEnd - cudaStart).count();
+        runAndPrintAllResults(true, totalHands, cudaElapsed, cudaResults);
+
+        // Print speedup comparison
+        double speedup = cpuElapsed / cudaElapsed;
+        std::cout << "\nPerformance Comparison:\n"
+                  << "----------------\n"
+                  << "CPU Time: " << std::fixed << std::setprecision(2) << cpuElapsed << "s\n"
+                  << "GPU Time: " << std::fixed << std::setprecision(2) << cudaElapsed << "s\n"
+                  << "CUDA Speedup: " << std::fixed << std::setprecision(2) << speedup << "x\n";
+      } else {
+        auto start = std::chrono::high_resolution_clock::now();
+        HandTypeCounts results =
+            useCuda ? calculateAllProbabilitiesCUDA(totalHands) : runCpu(totalHands, source, jobOptions);
+        auto end = std::chrono::high_resolution_clock::now();
+        double elapsed = std::chrono::duration<double>(end - start).count();
+        runAndPrintAllResults(useCuda, totalHands, elapsed, results);
+      }
     } else {
-      auto start = std::chrono::high_resolution_clock::now();
-      HandTypeCounts results =
-          useCuda ? calculateAllProbabilitiesCUDA(totalHands) : calculateAllProbabilities(totalHands);
-      auto end = std::chrono::high_resolution_clock::now();
-      auto elapsed = std::chrono::duration<double>(end - start).count();
-      runAndPrintResults(useCuda, targetType, results, elapsed, totalHands);
+      if (benchmark) {
+        // CPU implementation
+        std::cout << "\nRunning CPU implementation...\n";
+        auto start = std::chrono::high_resolution_clock::now();
+        HandTypeCounts cpuResults = runCpu(totalHands, source, jobOptions);
+        auto end = std::chrono::high_resolution_clock::now();
+        auto cpuElapsed = std::chrono::duration<double>(end - start).count();
+        runAndPrintResults(false, targetType, cpuResults, cpuElapsed, totalHands);
+
+        // CUDA implementation
+        std::cout << "\nRunning CUDA implementation...\n";
+        start = std::chrono::high_resolution_clock::now();
+        HandTypeCounts cudaResults = calculateAllProbabilitiesCUDA(totalHands);
+        end = std::chrono::high_resolution_clock::now();
+        auto cudaElapsed = std::chrono::duration<double>(end - start).count();
+        runAndPrintResults(true, targetType, cudaResults, cudaElapsed, totalHands);
+
+        // Print speedup comparison
+        double speedup = cpuElapsed / cudaElapsed;
+        std::cout << "\nPerformance Comparison:\n"
+                  << "----------------\n"
+                  << "CUDA Speedup: " << std::fixed << std::setprecision(2) << speedup << "x\n";
+      } else {
+        auto start = std::chrono::high_resolution_clock::now();
+        HandTypeCounts results =
+            useCuda ? calculateAllProbabilitiesCUDA(totalHands) : runCpu(totalHands, source, jobOptions);
+        auto end = std::chrono::high_resolution_clock::now();
+        auto elapsed = std::chrono::duration<double>(end - start).count();
+        runAndPrintResults(useCuda, targetType, results, elapsed, totalHands);
+      }
     }
+  } catch (const std::exception& e) {
+    std::cerr << "\nError: " << e.what() << "\n";
+    return 1;
   }
 
   return 0;
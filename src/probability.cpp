@@ -1,100 +1,254 @@
 #include "probability.hpp"
 #include <algorithm>
-#include <atomic>
-#include <iostream>
-#include <thread>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 #include "deck.hpp"
 #include "hand.hpp"
-#include "utils.hpp"
+#include "probability_jobs.hpp"
+#include "strength.hpp"
 
-std::atomic<unsigned long long> handTypeCount{0};
-std::atomic<HandTypeCounts*> globalCounts;
+namespace {
 
-void simulateHands(HandType targetType, int numHands, int threadId, int totalThreads) {
-  unsigned long long localCount = 0;  // Local counter for this thread
-  Deck deck;                          // Create deck once per thread
+const int HANDS_PER_CHUNK = 1 << 16;
+const int PROGRESS_INTERVAL = 4096;  // Hands between stop checks and progress updates
+
+uint64_t resolveSeed(const JobOptions& options) {
+  if (options.seed != 0) return options.seed;
+  std::random_device rd;
+  return (static_cast<uint64_t>(rd()) << 32) | rd();
+}
+
+// Each chunk owns a generator derived from (seed, chunk), so results do not depend on
+// which worker ran the chunk
+std::mt19937 chunkGenerator(uint64_t seed, size_t chunk) {
+  std::seed_seq seq{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32), static_cast<uint32_t>(chunk)};
+  return std::mt19937(seq);
+}
+
+void simulateChunk(int numHands, std::mt19937& rng, HandTypeCounts& counts, JobControl& control, HandBlock* record) {
+  Deck deck;
+  uint8_t cards[5];
 
   for (int i = 0; i < numHands; ++i) {
     if (i % 10 == 0) {
       deck.reset();
-      deck.shuffle();
+      deck.shuffle(rng);
     }
-    
-    Hand hand(deck.dealHand(5));
 
-    if (hand.getHandType() == targetType) {
-      localCount++;
-    }
+    for (int c = 0; c < 5; ++c) cards[c] = deck.dealCard().getValue();
+    if (record) record->add(cards);
+
+    Hand hand(std::vector<uint8_t>(cards, cards + 5));
+    counts.addHand(hand.getHandType());
 
-    if (threadId == 0 && i % 10000 == 0) {
-      float progress = static_cast<float>(i) / numHands;
-      printProgress(progress);
+    if ((i + 1) % PROGRESS_INTERVAL == 0) {
+      control.addProgress(PROGRESS_INTERVAL);
+      if (control.stopRequested()) return;
     }
   }
+  control.addProgress(numHands % PROGRESS_INTERVAL);
+}
+
+// Enumerates every hand whose lowest card is `first`; card values double as deck indices
+void enumerateChunk(uint8_t first, HandTypeCounts& counts, JobControl& control) {
+  std::vector<uint8_t> cards(5);
+  cards[0] = first;
 
-  handTypeCount += localCount;  // Add local count to global atomic counter
+  for (uint8_t b = first + 1; b < 52; ++b) {
+    cards[1] = b;
+    unsigned long long dealt = 0;
+    for (uint8_t c = b + 1; c < 52; ++c) {
+      cards[2] = c;
+      for (uint8_t d = c + 1; d < 52; ++d) {
+        cards[3] = d;
+        for (uint8_t e = d + 1; e < 52; ++e) {
+          cards[4] = e;
+          counts.addHand(Hand(cards).getHandType());
+        }
+        dealt += 51 - d;
+      }
+    }
+    control.addProgress(dealt);
+    if (control.stopRequested()) return;
+  }
 }
 
-void simulateHandsAllTypes(int numHands, int threadId, int totalThreads) {
-  auto localCounts = std::make_unique<HandTypeCounts>();
+void simulateStrengthChunk(int numHands, int cardsPerHand, std::mt19937& rng, StrengthChunkCounts& counts,
+                           JobControl& control, HandBlock* record) {
   Deck deck;
+  const int handsPerShuffle = 52 / cardsPerHand;
+  uint8_t cards[7];
 
   for (int i = 0; i < numHands; ++i) {
-    if (i % 10 == 0) {
+    if (i % handsPerShuffle == 0) {
       deck.reset();
-      deck.shuffle();
+      deck.shuffle(rng);
     }
 
-    Hand hand(deck.dealHand(5));
+    for (int c = 0; c < cardsPerHand; ++c) cards[c] = deck.dealCard().getValue();
+    if (record) record->add(cards);
+    counts.addHand(strengthClass(cards, cardsPerHand));
 
-    HandType type = hand.getHandType();
-    localCounts->counts[static_cast<size_t>(type)]++;
-
-    if (threadId == 0 && i % 10000 == 0) {
-      float progress = static_cast<float>(i) / numHands;
-      printProgress(progress);
+    if ((i + 1) % PROGRESS_INTERVAL == 0) {
+      control.addProgress(PROGRESS_INTERVAL);
+      if (control.stopRequested()) return;
     }
   }
+  control.addProgress(numHands % PROGRESS_INTERVAL);
+}
 
-  // Update global counts atomically
-  HandTypeCounts* current;
-  HandTypeCounts* updated;
-  do {
-    current = globalCounts.load(std::memory_order_acquire);
-    updated = new HandTypeCounts(*current);
-    for (size_t i = 0; i < static_cast<size_t>(HandType::Count); ++i) {
-      updated->counts[i] += localCounts->counts[i];
+// Enumerates every hand whose two lowest cards are `first` and `second`
+void enumerateStrengthChunk(uint8_t first, uint8_t second, int cardsPerHand, StrengthChunkCounts& counts,
+                            JobControl& control) {
+  uint8_t cards[7] = {first, second};
+  for (int i = 2; i < cardsPerHand; ++i) cards[i] = static_cast<uint8_t>(second + i - 1);
+  unsigned long long dealt = 0;
+
+  for (;;) {
+    counts.addHand(strengthClass(cards, cardsPerHand));
+    if (++dealt % PROGRESS_INTERVAL == 0) {
+      control.addProgress(PROGRESS_INTERVAL);
+      if (control.stopRequested()) return;
     }
-  } while (
-      !globalCounts.compare_exchange_weak(current, updated, std::memory_order_release, std::memory_order_relaxed));
-  delete current;
+
+    int i = cardsPerHand - 1;
+    while (i >= 2 && cards[i] == 52 - cardsPerHand + i) --i;
+    if (i < 2) break;
+    ++cards[i];
+    for (int j = i + 1; j < cardsPerHand; ++j) cards[j] = static_cast<uint8_t>(cards[j - 1] + 1);
+  }
+  control.addProgress(dealt % PROGRESS_INTERVAL);
 }
 
-HandTypeCounts calculateAllProbabilities(int totalHands) {
-  auto initial = new HandTypeCounts();
-  globalCounts.store(initial);
+void checkTotalHands(int totalHands) {
+  if (totalHands < 0) throw std::invalid_argument("Number of hands must not be negative");
+}
 
-  unsigned int numThreads = std::thread::hardware_concurrency();
-  if (numThreads == 0) numThreads = 4;
+void checkCardsPerHand(int cardsPerHand) {
+  if (cardsPerHand < 5 || cardsPerHand > 7) throw std::invalid_argument("Hands must have 5 to 7 cards");
+}
 
-  std::vector<std::thread> threads;
-  int handsPerThread = totalHands / numThreads;
+std::shared_ptr<HandStreamWriter> openRecorder(const std::string& path, int cardsPerHand, int totalHands) {
+  if (path.empty()) return nullptr;
+  return std::make_shared<HandStreamWriter>(path, cardsPerHand, totalHands, HANDS_PER_CHUNK);
+}
 
-  for (unsigned int i = 0; i < numThreads - 1; ++i) {
-    threads.emplace_back(simulateHandsAllTypes, handsPerThread, i, numThreads);
+// Runs a simulation chunk, recording its hands as the stream block with the same index.
+// A chunk cut short by cancellation or the deadline is not written, leaving the stream incomplete.
+template <typename Simulate>
+void simulateRecorded(size_t chunk, HandStreamWriter* recorder, const JobControl& control, Simulate simulate) {
+  if (!recorder) {
+    simulate(static_cast<HandBlock*>(nullptr));
+    return;
   }
-  simulateHandsAllTypes(totalHands - (handsPerThread * (numThreads - 1)), numThreads - 1, numThreads);
+  HandBlock block = recorder->newBlock();
+  simulate(&block);
+  if (!control.stopRequested()) recorder->write(chunk, block);
+}
+
+}  // namespace
+
+JobHandle<HandTypeCounts> submitSimulation(int totalHands, const JobOptions& options, const std::string& recordPath) {
+  checkTotalHands(totalHands);
+  uint64_t seed = resolveSeed(options);
+  size_t chunks = (static_cast<size_t>(totalHands) + HANDS_PER_CHUNK - 1) / HANDS_PER_CHUNK;
+  std::shared_ptr<HandStreamWriter> recorder = openRecorder(recordPath, 5, totalHands);
+
+  return submitJob<HandTypeCounts>(
+      chunks, totalHands,
+      [seed, totalHands, recorder](size_t chunk, HandTypeCounts& counts, JobControl& control) {
+        int begin = static_cast<int>(chunk) * HANDS_PER_CHUNK;
+        int numHands = std::min(HANDS_PER_CHUNK, totalHands - begin);
+        std::mt19937 rng = chunkGenerator(seed, chunk);
+        simulateRecorded(chunk, recorder.get(), control,
+                         [&](HandBlock* record) { simulateChunk(numHands, rng, counts, control, record); });
+      },
+      options);
+}
+
+JobHandle<HandTypeCounts> submitEnumeration(const JobOptions& options) {
+  const unsigned long long totalHands = 2598960;  // C(52,5)
+
+  return submitJob<HandTypeCounts>(
+      48, totalHands,
+      [](size_t chunk, HandTypeCounts& counts, JobControl& control) {
+        enumerateChunk(static_cast<uint8_t>(chunk), counts, control);
+      },
+      options);
+}
+
+JobHandle<StrengthHistogram> submitStrengthSimulation(int totalHands, int cardsPerHand, const JobOptions& options,
+                                                      const std::string& recordPath) {
+  checkTotalHands(totalHands);
+  checkCardsPerHand(cardsPerHand);
+  uint64_t seed = resolveSeed(options);
+  size_t chunks = (static_cast<size_t>(totalHands) + HANDS_PER_CHUNK - 1) / HANDS_PER_CHUNK;
+  std::shared_ptr<HandStreamWriter> recorder = openRecorder(recordPath, cardsPerHand, totalHands);
 
-  for (auto& thread : threads) {
-    thread.join();
+  return submitJob<StrengthHistogram, StrengthChunkCounts>(
+      chunks, totalHands,
+      [seed, totalHands, cardsPerHand, recorder](size_t chunk, StrengthChunkCounts& counts, JobControl& control) {
+        int begin = static_cast<int>(chunk) * HANDS_PER_CHUNK;
+        int numHands = std::min(HANDS_PER_CHUNK, totalHands - begin);
+        std::mt19937 rng = chunkGenerator(seed, chunk);
+        simulateRecorded(chunk, recorder.get(), control, [&](HandBlock* record) {
+          simulateStrengthChunk(numHands, cardsPerHand, rng, counts, control, record);
+        });
+      },
+      options, StrengthHistogram(cardsPerHand));
+}
+
+JobHandle<StrengthHistogram> submitStrengthEnumeration(int cardsPerHand, const JobOptions& options) {
+  checkCardsPerHand(cardsPerHand);
+  std::vector<std::pair<uint8_t, uint8_t>> prefixes;
+  for (uint8_t a = 0; a < 52; ++a) {
+    for (uint8_t b = a + 1; b <= 53 - cardsPerHand; ++b) prefixes.emplace_back(a, b);
   }
 
-  HandTypeCounts result = *globalCounts.load();
-  delete globalCounts.load();
-  return result;
+  unsigned long long totalHands = 1;
+  for (int i = 0; i < cardsPerHand; ++i) totalHands = totalHands * (52 - i) / (i + 1);  // C(52, cardsPerHand)
+
+  return submitJob<StrengthHistogram, StrengthChunkCounts>(
+      prefixes.size(), totalHands,
+      [prefixes, cardsPerHand](size_t chunk, StrengthChunkCounts& counts, JobControl& control) {
+        enumerateStrengthChunk(prefixes[chunk].first, prefixes[chunk].second, cardsPerHand, counts, control);
+      },
+      options, StrengthHistogram(cardsPerHand));
+}
+
+JobHandle<HandTypeCounts> submitReplay(std::shared_ptr<const HandStream> stream, const JobOptions& options) {
+  if (stream->getCardsPerHand() != 5) throw std::invalid_argument("Hand type replay needs 5-card hands");
+
+  return submitJob<HandTypeCounts>(
+      stream->getBlockCount(), stream->getTotalHands(),
+      [stream](size_t block, HandTypeCounts& counts, JobControl& control) {
+        // Same evaluator as simulateChunk, so a replay reproduces the live run exactly
+        stream->forEachHand(block, [&](const uint8_t* cards) {
+          counts.addHand(Hand(std::vector<uint8_t>(cards, cards + 5)).getHandType());
+        });
+        control.addProgress(stream->handsInBlock(block));
+      },
+      options);
 }
 
+JobHandle<StrengthHistogram> submitStrengthReplay(std::shared_ptr<const HandStream> stream,
+                                                  const JobOptions& options) {
+  const int cardsPerHand = stream->getCardsPerHand();
+
+  return submitJob<StrengthHistogram, StrengthChunkCounts>(
+      stream->getBlockCount(), stream->getTotalHands(),
+      [stream, cardsPerHand](size_t block, StrengthChunkCounts& counts, JobControl& control) {
+        stream->forEachHand(block, [&](const uint8_t* cards) { counts.addHand(strengthClass(cards, cardsPerHand)); });
+        control.addProgress(stream->handsInBlock(block));
+      },
+      options, StrengthHistogram(cardsPerHand));
+}
+
+HandTypeCounts calculateAllProbabilities(int totalHands) { return submitSimulation(totalHands).get(); }
+
 double calculateHandTypeProbability(HandType type, int totalHands) {
   HandTypeCounts results = calculateAllProbabilities(totalHands);
   return results.getProbability(type);
@@ -0,0 +1,170 @@
+#include "strength.hpp"
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+enum Category {
+  HIGH_CARD,
+  ONE_PAIR,
+  TWO_PAIR,
+  THREE_OF_A_KIND,
+  STRAIGHT,
+  FLUSH,
+  FULL_HOUSE,
+  FOUR_OF_A_KIND,
+  STRAIGHT_FLUSH
+};
+
+int highestRank(unsigned mask) {
+  for (int r = 12; r >= 0; --r) {
+    if (mask & (1u << r)) return r;
+  }
+  return -1;
+}
+
+int countRanks(unsigned mask) {
+  int n = 0;
+  for (; mask; mask &= mask - 1) ++n;
+  return n;
+}
+
+// Top rank of the highest straight in mask (3 for A-2-3-4-5), or -1
+int straightTop(unsigned mask) {
+  for (int top = 12; top >= 4; --top) {
+    if (((mask >> (top - 4)) & 0x1F) == 0x1F) return top;
+  }
+  return (mask & 0x100F) == 0x100F ? 3 : -1;
+}
+
+// Comparable key: category in the top bits, then up to five deciding ranks, most significant first
+class KeyBuilder {
+ public:
+  explicit KeyBuilder(Category category) : key(category), ranks(0) {}
+  KeyBuilder& rank(int r) {
+    key = key << 4 | static_cast<uint32_t>(r);
+    ++ranks;
+    return *this;
+  }
+  KeyBuilder& highest(unsigned mask, int n) {
+    for (int i = 0; i < n; ++i) {
+      int r = highestRank(mask);
+      rank(r);
+      mask &= ~(1u << r);
+    }
+    return *this;
+  }
+  uint32_t build() const { return key << (4 * (5 - ranks)); }
+
+ private:
+  uint32_t key;
+  int ranks;
+};
+
+uint32_t strengthKey(const uint8_t* cards, int count) {
+  int rankCount[13] = {0};
+  unsigned suitRanks[4] = {0};
+  unsigned rankMask = 0;
+  for (int i = 0; i < count; ++i) {
+    int rank = cards[i] >> 2;
+    rankCount[rank]++;
+    suitRanks[cards[i] & 0x3] |= 1u << rank;
+    rankMask |= 1u << rank;
+  }
+
+  // With at most seven cards a flush rules out quads and full houses, so it can be settled first
+  for (unsigned suited : suitRanks) {
+    if (countRanks(suited) < 5) continue;
+    int top = straightTop(suited);
+    if (top >= 0) return KeyBuilder(STRAIGHT_FLUSH).rank(top).build();
+    return KeyBuilder(FLUSH).highest(suited, 5).build();
+  }
+
+  unsigned pairs = 0, trips = 0, quads = 0;
+  for (int r = 0; r < 13; ++r) {
+    if (rankCount[r] == 4) quads |= 1u << r;
+    if (rankCount[r] == 3) trips |= 1u << r;
+    if (rankCount[r] == 2) pairs |= 1u << r;
+  }
+
+  if (quads) {
+    int quad = highestRank(quads);
+    return KeyBuilder(FOUR_OF_A_KIND).rank(quad).highest(rankMask & ~(1u << quad), 1).build();
+  }
+  if (trips) {
+    int trip = highestRank(trips);
+    unsigned rest = (trips & ~(1u << trip)) | pairs;
+    if (rest) return KeyBuilder(FULL_HOUSE).rank(trip).highest(rest, 1).build();
+  }
+  int top = straightTop(rankMask);
+  if (top >= 0) return KeyBuilder(STRAIGHT).rank(top).build();
+  if (trips) {
+    int trip = highestRank(trips);
+    return KeyBuilder(THREE_OF_A_KIND).rank(trip).highest(rankMask & ~(1u << trip), 2).build();
+  }
+  if (countRanks(pairs) >= 2) {
+    int high = highestRank(pairs);
+    int low = highestRank(pairs & ~(1u << high));
+    unsigned rest = rankMask & ~(1u << high) & ~(1u << low);
+    return KeyBuilder(TWO_PAIR).rank(high).rank(low).highest(rest, 1).build();
+  }
+  if (pairs) {
+    int pair = highestRank(pairs);
+    return KeyBuilder(ONE_PAIR).rank(pair).highest(rankMask & ~(1u << pair), 3).build();
+  }
+  return KeyBuilder(HIGH_CARD).highest(rankMask, 5).build();
+}
+
+// Keys of every distinct five-card strength, strongest first
+const std::vector<uint32_t>& classKeys() {
+  static const std::vector<uint32_t> keys = [] {
+    std::vector<uint32_t> result;
+    uint8_t cards[5];
+    int r[5];
+    for (r[0] = 0; r[0] < 13; ++r[0])
+      for (r[1] = r[0]; r[1] < 13; ++r[1])
+        for (r[2] = r[1]; r[2] < 13; ++r[2])
+          for (r[3] = r[2]; r[3] < 13; ++r[3])
+            for (r[4] = r[3]; r[4] < 13; ++r[4]) {
+              if (r[0] == r[4]) continue;  // Five of a kind
+              // Cycling suits by position never repeats a suit within a rank or makes a flush
+              for (int i = 0; i < 5; ++i) cards[i] = static_cast<uint8_t>(r[i] << 2 | (i % 4));
+              result.push_back(strengthKey(cards, 5));
+
+              if (r[0] < r[1] && r[1] < r[2] && r[2] < r[3] && r[3] < r[4]) {
+                for (int i = 0; i < 5; ++i) cards[i] = static_cast<uint8_t>(r[i] << 2);
+                result.push_back(strengthKey(cards, 5));
+              }
+            }
+    std::sort(result.begin(), result.end(), std::greater<uint32_t>());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    if (result.size() != NUM_STRENGTH_CLASSES) throw std::logic_error("Unexpected number of strength classes");
+    return result;
+  }();
+  return keys;
+}
+
+}  // namespace
+
+uint16_t strengthClass(const uint8_t* cards, int count) {
+  const std::vector<uint32_t>& keys = classKeys();
+  auto it = std::lower_bound(keys.begin(), keys.end(), strengthKey(cards, count), std::greater<uint32_t>());
+  return static_cast<uint16_t>(it - keys.begin());
+}
+
+HandType strengthClassType(uint16_t strengthClass) {
+  uint32_t key = classKeys()[strengthClass];
+  switch (static_cast<Category>(key >> 20)) {
+    case STRAIGHT_FLUSH: return (key >> 16 & 0xF) == 12 ? HandType::RoyalFlush : HandType::StraightFlush;
+    case FOUR_OF_A_KIND: return HandType::FourOfAKind;
+    case FULL_HOUSE: return HandType::FullHouse;
+    case FLUSH: return HandType::Flush;
+    case STRAIGHT: return HandType::Straight;
+    case THREE_OF_A_KIND: return HandType::ThreeOfAKind;
+    case TWO_PAIR: return HandType::TwoPair;
+    case ONE_PAIR: return HandType::OnePair;
+    default: return HandType::HighCard;
+  }
+}
@@ -0,0 +1,60 @@
+#include "thread_pool.hpp"
+#include <utility>
+
+ThreadPool& ThreadPool::instance() {
+  static ThreadPool pool([] {
+    unsigned int n = std::thread::hardware_concurrency();
+    return n == 0 ? 4u : n;
+  }());
+  return pool;
+}
+
+ThreadPool::ThreadPool(unsigned int numThreads) {
+  workers.reserve(numThreads);
+  for (unsigned int i = 0; i < numThreads; ++i) {
+    workers.emplace_back(&ThreadPool::workerLoop, this);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  available.notify_all();
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+void ThreadPool::submit(std::shared_ptr<PoolTask> task) {
+  size_t chunks = task->chunkCount();
+  if (chunks == 0) return;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    queue.push_back(Entry{std::move(task), 0, chunks});
+  }
+  available.notify_all();
+}
+
+void ThreadPool::workerLoop() {
+  for (;;) {
+    std::shared_ptr<PoolTask> task;
+    size_t chunk;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      available.wait(lock, [this] { return stopping || !queue.empty(); });
+      if (queue.empty()) return;  // Only reached once stopping and drained
+
+      // Take one chunk from the front task and rotate it to the back
+      Entry entry = std::move(queue.front());
+      queue.pop_front();
+      task = entry.task;
+      chunk = entry.nextChunk++;
+      if (entry.nextChunk < entry.chunkCount) {
+        queue.push_back(std::move(entry));
+      }
+    }
+    task->runChunk(chunk);
+  }
+}